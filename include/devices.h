@@ -0,0 +1,52 @@
+#ifndef DEVICES_H
+#define DEVICES_H
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "linux_parser.h"
+
+struct NetRate {
+  std::string name;
+  float rx_bytes_per_second{0};
+  float tx_bytes_per_second{0};
+};
+
+struct DiskRate {
+  std::string name;
+  float iops{0};
+  float read_bytes_per_second{0};
+  float write_bytes_per_second{0};
+  float utilization{0};  // fraction of the interval the device was busy
+};
+
+/*
+Network interface and block device throughput, computed like
+Processor::Utilization() from the difference of the counters of two
+consecutive refreshes.
+Virtual devices (loopback, bridges, loop, zram, ...) and partitions are
+hidden unless ShowAll(true) is set.
+*/
+class Devices {
+ public:
+  void Update();
+  void ShowAll(bool show);
+  std::vector<NetRate>& Network();
+  std::vector<DiskRate>& Disks();
+
+ private:
+  bool Hidden(std::string const& name, bool block);
+
+  bool show_all{false};
+  std::vector<LinuxParser::NetDevice> net_, prev_net_;
+  std::vector<LinuxParser::DiskDevice> disks_, prev_disks_;
+  std::vector<NetRate> net_rates_;
+  std::vector<DiskRate> disk_rates_;
+  // the result of the /sys lookups, devices rarely come and go
+  std::map<std::string, bool> hidden_net_, hidden_disks_;
+  std::chrono::steady_clock::time_point last_update;
+};
+
+#endif
@@ -5,6 +5,7 @@
 
 namespace Format {
 std::string ElapsedTime(long times);  
+std::string Bytes(unsigned long long bytes);
 };                                    
 
 #endif
\ No newline at end of file
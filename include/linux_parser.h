@@ -4,10 +4,13 @@
 #include <fstream>
 #include <regex>
 #include <string>
+#include <vector>
 
 namespace LinuxParser {
 // Paths
-const std::string kProcDirectory{"/proc/"};
+// /proc and /sys can be moved with SetRootDirectory(), e.g. to a synthetic
+// tree for testing, so unlike the other paths they are not const
+inline std::string kProcDirectory{"/proc/"};
 const std::string kCmdlineFilename{"/cmdline"};
 const std::string kCpuinfoFilename{"/cpuinfo"};
 const std::string kStatusFilename{"/status"};
@@ -15,9 +18,21 @@ const std::string kStatFilename{"/stat"};
 const std::string kUptimeFilename{"/uptime"};
 const std::string kMeminfoFilename{"/meminfo"};
 const std::string kVersionFilename{"/version"};
+const std::string kLoadavgFilename{"/loadavg"};
+const std::string kPressureDirectory{"/pressure/"};
+const std::string kNetDevFilename{"/net/dev"};
+const std::string kDiskstatsFilename{"/diskstats"};
+inline std::string kSysDirectory{"/sys/"};
+const std::string kVirtualNetDirectory{"/devices/virtual/net/"};
+const std::string kVirtualBlockDirectory{"/devices/virtual/block/"};
+const std::string kBlockDirectory{"/block/"};
+const std::string kNumaMapsFilename{"/numa_maps"};
+const std::string kNodeDirectory{"/devices/system/node/"};
 const std::string kOSPath{"/etc/os-release"};
 const std::string kPasswordPath{"/etc/passwd"};
 
+void SetRootDirectory(std::string const& root);
+
 template <typename T>
 T findValueByKey(std::string const &keyFilter, std::string const &filename) {
   std::string line, key;
@@ -52,6 +67,34 @@ T getValueOfFile(std::string const &filename) {
 };
 
 // System
+// values of /proc/meminfo in kB
+struct MemInfo {
+  long total{0};
+  long free{0};
+  long available{0};
+  long buffers{0};
+  long cached{0};
+  long swap_total{0};
+  long swap_free{0};
+};
+struct LoadAverage {
+  float one{0};
+  float five{0};
+  float fifteen{0};
+};
+// pressure stall information, /proc/pressure/{cpu,memory,io}
+enum PressureResources { kPressureCpu_ = 0, kPressureMemory_, kPressureIO_ };
+struct Pressure {
+  bool available{false};
+  float some_avg10{0};
+  float some_avg60{0};
+  float full_avg10{0};
+  float full_avg60{0};
+};
+bool ParseMemInfo(MemInfo& meminfo);
+bool ParseUpTime(double& seconds);
+bool ParseLoadAverage(LoadAverage& loadavg);
+bool ParsePressure(int resource, Pressure& pressure);
 float MemoryUtilization();
 long UpTime();
 std::vector<int> Pids();
@@ -73,14 +116,72 @@ enum CPUStates {
   kGuest_,
   kGuestNice_
 };
+struct CpuTimes {
+  int id{-1};  // N of "cpuN", -1 for the sum over all cores
+  long jiffies[kGuestNice_ + 1]{};
+  long Active() const;
+  long Idle() const;
+  long Total() const;
+};
+// Everything the monitor needs from /proc/stat, parsed from a single read
+struct StatInfo {
+  CpuTimes cpu;
+  std::vector<CpuTimes> cores;
+  unsigned long long context_switches{0};
+  unsigned long long interrupts{0};
+  int processes{0};
+  int procs_running{0};
+};
+bool ParseStat(StatInfo& stat);
 std::vector<std::string> CpuUtilization();
 long Jiffies();
 long ActiveJiffies();
 long ActiveJiffies(int pid);
 long IdleJiffies();
 
+// Devices
+// counters of one interface in /proc/net/dev
+struct NetDevice {
+  std::string name;
+  unsigned long long rx_bytes{0};
+  unsigned long long tx_bytes{0};
+};
+// counters of one block device in /proc/diskstats
+struct DiskDevice {
+  std::string name;
+  unsigned long long reads{0};
+  unsigned long long sectors_read{0};
+  unsigned long long writes{0};
+  unsigned long long sectors_written{0};
+  unsigned long long io_ticks{0};  // ms spent doing I/O
+};
+bool ParseNetDev(std::vector<NetDevice>& devices);
+bool ParseDiskStats(std::vector<DiskDevice>& devices);
+bool IsVirtualNetDevice(std::string const& name);
+bool IsVirtualBlockDevice(std::string const& name);
+bool IsPartition(std::string const& name);
+
+// NUMA
+// node of every CPU, indexed by CPU number, -1 for CPUs without a node
+bool CpuNodes(std::vector<int>& cpu_nodes);
+bool NodeMemory(int node, long& total_kb, long& free_kb);
+
 // Processes
+// the fields of /proc/[pid]/stat the monitor uses, from a single read
+struct ProcessStat {
+  char state{'?'};
+  int ppid{0};
+  long utime{0};
+  long stime{0};
+  long cutime{0};
+  long cstime{0};
+  long starttime{0};
+  int processor{-1};  // CPU the process last ran on
+};
+bool ParseProcessStat(int pid, ProcessStat& stat);
 std::string Command(int pid);
+std::string CpusAllowed(int pid);
+bool NumaMemory(int pid, std::vector<long>& node_kb);
 std::string Ram(int pid);
 std::string Uid(int pid);
 std::string User(int pid);
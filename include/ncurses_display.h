@@ -9,7 +9,13 @@
 namespace NCursesDisplay {
 void Display(System& system, int n = 10);
 void DisplaySystem(System& system, WINDOW* window);
-void DisplayProcesses(std::vector<Process>& processes, WINDOW* window, int n);
+void DisplayMetrics(System& system, WINDOW* window);
+void DisplayDevices(Devices& devices, WINDOW* window, int n);
+void DisplayProcesses(std::vector<Process>& processes, WINDOW* window, int n,
+                      bool numa = false);
+void DisplayNuma(NumaNodes& numa, WINDOW* window);
+void DisplayExited(std::vector<ExitedGroup>& groups, float total_cpu,
+                   bool complete, WINDOW* window, int n);
 std::string ProgressBar(float percent);
 };  // namespace NCursesDisplay
 
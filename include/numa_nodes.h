@@ -0,0 +1,40 @@
+#ifndef NUMA_NODES_H
+#define NUMA_NODES_H
+
+#include <vector>
+
+#include "linux_parser.h"
+
+struct NodeLoad {
+  int id{0};
+  int cpus{0};
+  float utilization{0};
+  long mem_total_kb{0};
+  long mem_free_kb{0};
+};
+
+/*
+Per NUMA node view of the machine: the CPU utilization of every node,
+summed up from the per-core counters of /proc/stat the same way Processor
+does it for the whole machine, and the memory of the node from sysfs.
+On single node machines (or kernels without NUMA) Count() is at most 1 and
+nothing is computed.
+*/
+class NumaNodes {
+ public:
+  void Update(std::vector<LinuxParser::CpuTimes> const& cores);
+  int Count();
+  std::vector<NodeLoad>& Nodes();
+
+ private:
+  void Load();
+
+  bool loaded{false};
+  std::vector<int> cpu_nodes_;   // node of every CPU
+  std::vector<int> node_index_;  // position in nodes_ of every node
+  std::vector<long> prev_active_, prev_total_;  // per CPU
+  std::vector<long> active_delta_, total_delta_;  // per node
+  std::vector<NodeLoad> nodes_;
+};
+
+#endif
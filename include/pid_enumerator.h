@@ -0,0 +1,28 @@
+#ifndef PID_ENUMERATOR_H
+#define PID_ENUMERATOR_H
+
+#include <vector>
+
+/*
+Lists the process IDs in /proc like LinuxParser::Pids(), but without
+allocating on every refresh: /proc stays open, directory entries are read
+with getdents64 into a buffer that is reused, and the names are converted
+to numbers in place. The PIDs are returned in ascending order so they can
+be merged with a table ordered by PID in linear time. The inode of every
+/proc/[pid] directory is returned alongside: a new process gets a new
+inode, so it tells when a PID has been reused.
+*/
+class PidEnumerator {
+ public:
+  PidEnumerator();
+  ~PidEnumerator();
+  PidEnumerator(PidEnumerator const&) = delete;
+  PidEnumerator& operator=(PidEnumerator const&) = delete;
+  bool Scan(std::vector<int>& pids, std::vector<unsigned long>& inodes);
+
+ private:
+  int directory_fd{-1};
+  std::vector<char> buffer;
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define PROCESS_H
 
 #include <string>
+#include <vector>
 /*
 Basic class for Process representation
 It contains relevant attributes as shown below
@@ -17,12 +18,33 @@ class Process {
   bool operator<(Process const& a) const;  
   void setPID(int);
   float getCpuLoad() const;
-  void CalcCpuLoad();
+  bool CalcCpuLoad(double system_uptime);
+  double SampledCpuTime() const;
+  int LastCpu() const;
+  std::string CpusAllowed();
+  std::vector<long> NumaMemory();
+
+  // bookkeeping of the Scheduler, see scheduler.h
+  int IdleSamples() const;
+  long NextSample() const;
+  int SampleInterval() const;
+  void setSchedule(long next_sample, int interval);
+  // inode of /proc/[pid], changes when the PID is reused
+  unsigned long ProcInode() const;
+  void setProcInode(unsigned long inode);
 
  private:
     int pid{0};
-    float process_totaltime_old{0}, process_uptime_old{0};
-    float cpu_load;
+    // double: on long running hosts a float can't resolve 100 ms of uptime
+    double process_totaltime_old{0}, process_uptime_old{0};
+    float cpu_load{0};
+    long start_time{0};
+    long start_jiffies{-1};
+    unsigned long proc_inode{0};
+    int last_cpu{-1};
+    int idle_samples{0};
+    long next_sample{0};
+    int sample_interval{1};
 };
 
-#endif
\ No newline at end of file
+#endif
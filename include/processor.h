@@ -1,13 +1,17 @@
 #ifndef PROCESSOR_H
 #define PROCESSOR_H
 
+#include "linux_parser.h"
+
 class Processor {
  public:
   float Utilization();  
+  void Update(LinuxParser::CpuTimes const& times);
 
  private:
     long prevActiveJiffies{0};
     long prevJiffies{0};
+    float utilization{0};
 };
 
-#endif
\ No newline at end of file
+#endif
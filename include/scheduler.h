@@ -0,0 +1,38 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <chrono>
+
+#include "process.h"
+
+/*
+Decides on which refresh ("tick") a process is sampled next.
+Hot processes, i.e. the top-N by CPU and everything that got CPU time
+recently, are sampled on every tick. A process that stayed idle for
+kIdleSamples samples in a row has its sampling interval doubled after each
+further idle sample, up to max_interval ticks, so mostly idle hosts need far
+fewer reads of /proc per second.
+*/
+class Scheduler {
+ public:
+  void SetInterval(std::chrono::milliseconds interval);
+  std::chrono::milliseconds Interval() const;
+  void SetHotCount(int count);
+  int HotCount() const;
+  void BeginTick();
+  bool Due(Process const& process) const;
+  void Reschedule(Process& process, bool hot) const;
+  void Promote(Process& process) const;
+  void Wake(Process& process) const;
+
+  static constexpr int kIdleSamples{3};
+  static constexpr std::chrono::milliseconds kMinInterval{100};
+
+ private:
+  std::chrono::milliseconds interval{1000};
+  int hot_count{20};
+  int max_interval{32};
+  long tick{0};
+};
+
+#endif
@@ -1,15 +1,26 @@
 #ifndef SYSTEM_H
 #define SYSTEM_H
 
+#include <chrono>
 #include <string>
 #include <vector>
 
+#include "devices.h"
+#include "linux_parser.h"
+#include "numa_nodes.h"
+#include "pid_enumerator.h"
 #include "process.h"
 #include "processor.h"
+#include "scheduler.h"
+#include "taskstats.h"
 
 class System {
  public:
-  Processor& Cpu();                   
+  void Refresh();
+  Processor& Cpu();
+  Devices& Io();
+  Scheduler& Sampling();
+  NumaNodes& Numa();                   
   std::vector<Process>& Processes();  
   float MemoryUtilization();          
   long UpTime();                      
@@ -17,10 +28,40 @@ class System {
   int RunningProcesses();             
   std::string Kernel();               
   std::string OperatingSystem();      
+  LinuxParser::MemInfo const& MemInfo() const;
+  LinuxParser::LoadAverage const& LoadAverage() const;
+  LinuxParser::Pressure const& Pressure(int resource) const;
+  float ContextSwitchesPerSecond() const;
+  float InterruptsPerSecond() const;
+  bool EnableExitAccounting();
+  bool ExitAccountingEnabled() const;
+  std::vector<ExitedGroup>& ExitedProcesses();
+  float ExitedCpuUtilization() const;
+  bool ExitedProcessesComplete() const;
 
  private:
   Processor cpu_ = {};
+  Devices io_ = {};
+  NumaNodes numa_ = {};
   std::vector<Process> processes_ = {};
+  // all processes ordered by PID, kept from one refresh to the next
+  std::vector<Process> table_ = {};
+  std::vector<Process> next_table_ = {};
+  std::vector<int> hot_pids_ = {};
+  PidEnumerator pid_enumerator_;
+  std::vector<int> pids_ = {};
+  std::vector<unsigned long> inodes_ = {};
+  Scheduler scheduler_ = {};
+  double uptime_{0};
+  TaskStats taskstats_ = {};
+  // snapshots taken once per Refresh()
+  LinuxParser::StatInfo stat_ = {};
+  LinuxParser::MemInfo meminfo_ = {};
+  LinuxParser::LoadAverage loadavg_ = {};
+  LinuxParser::Pressure pressure_[LinuxParser::kPressureIO_ + 1] = {};
+  std::chrono::steady_clock::time_point last_refresh_ = {};
+  float context_switches_per_second_{0};
+  float interrupts_per_second_{0};
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,70 @@
+#ifndef TASKSTATS_H
+#define TASKSTATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+CPU and I/O of processes that exited during the last refresh interval,
+aggregated by parent PID and command name.
+*/
+struct ExitedGroup {
+  int ppid{0};
+  std::string command;
+  int count{0};
+  // CPU time within the last interval that the process list has not shown
+  std::uint64_t cpu_us{0};
+  std::uint64_t read_bytes{0};
+  std::uint64_t write_bytes{0};
+  // fraction of one CPU, same meaning as Process::CpuUtilization()
+  float cpu_load{0};
+};
+
+/*
+Listener for the kernel's taskstats exit notifications (generic netlink).
+Processes living shorter than one refresh never show up when scanning /proc,
+so their accounting record is collected here when they exit.
+Registering for exit records needs CAP_NET_ADMIN; Open() fails without
+it.
+*/
+class TaskStats {
+ public:
+  TaskStats() = default;
+  ~TaskStats();
+  TaskStats(TaskStats const&) = delete;
+  TaskStats& operator=(TaskStats const&) = delete;
+  bool Open();
+  bool IsOpen() const;
+  void Poll(std::function<double(int)> const& sampled_cpu);
+  std::vector<ExitedGroup>& Exited();
+  float TotalCpuLoad() const;
+  // false if the last Poll() had to leave out exit records
+  bool Complete() const;
+
+ private:
+  bool Send(std::uint16_t type, std::uint8_t command, std::uint16_t attribute,
+            void const* data, std::size_t length);
+  bool ResolveFamilyId();
+  void HandleMessages(char const* data, std::size_t length);
+  void HandleStats(char const* data, std::size_t length);
+
+  int socket_fd{-1};
+  std::uint16_t family_id{0};
+  std::string cpumask;
+  std::vector<char> buffer;
+  std::map<std::pair<int, std::string>, ExitedGroup> groups_;
+  std::vector<ExitedGroup> exited_;
+  std::chrono::steady_clock::time_point last_poll;
+  float interval_us{0};
+  // valid during Poll(), see there
+  std::function<double(int)> const* sampled_cpu_{nullptr};
+  float total_cpu_load{0};
+  bool complete_{true};
+};
+
+#endif
@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "devices.h"
+#include "linux_parser.h"
+
+using std::string;
+using std::vector;
+
+namespace {
+// devices usually keep their position between two reads, so try that first
+template <typename T>
+T const* FindPrevious(vector<T> const& previous, std::size_t index,
+                      string const& name) {
+  if (index < previous.size() && previous[index].name == name) {
+    return &previous[index];
+  }
+  for (T const& device : previous) {
+    if (device.name == name) {
+      return &device;
+    }
+  }
+  return nullptr;
+}
+}  // namespace
+
+void Devices::ShowAll(bool show) { show_all = show; }
+
+bool Devices::Hidden(string const& name, bool block) {
+  if (show_all) {
+    return false;
+  }
+  std::map<string, bool>& cache = block ? hidden_disks_ : hidden_net_;
+  auto entry = cache.find(name);
+  if (entry == cache.end()) {
+    bool hidden = block ? LinuxParser::IsVirtualBlockDevice(name) ||
+                              LinuxParser::IsPartition(name)
+                        : LinuxParser::IsVirtualNetDevice(name);
+    entry = cache.emplace(name, hidden).first;
+  }
+  return entry->second;
+}
+
+void Devices::Update() {
+  // keep the counters of the last refresh, the buffers are swapped not copied
+  std::swap(net_, prev_net_);
+  std::swap(disks_, prev_disks_);
+  LinuxParser::ParseNetDev(net_);
+  LinuxParser::ParseDiskStats(disks_);
+
+  auto now = std::chrono::steady_clock::now();
+  float seconds = std::chrono::duration<float>(now - last_update).count();
+  last_update = now;
+
+  std::size_t count{0};
+  for (std::size_t i = 0; i < net_.size(); ++i) {
+    LinuxParser::NetDevice const& device = net_[i];
+    LinuxParser::NetDevice const* previous =
+        FindPrevious(prev_net_, i, device.name);
+    // counters start again from zero when an interface is re-created
+    if (previous == nullptr || device.rx_bytes < previous->rx_bytes ||
+        device.tx_bytes < previous->tx_bytes || Hidden(device.name, false)) {
+      continue;
+    }
+    if (count == net_rates_.size()) {
+      net_rates_.emplace_back();
+    }
+    NetRate& rate = net_rates_[count++];
+    rate.name = device.name;
+    rate.rx_bytes_per_second = (device.rx_bytes - previous->rx_bytes) / seconds;
+    rate.tx_bytes_per_second = (device.tx_bytes - previous->tx_bytes) / seconds;
+  }
+  net_rates_.resize(count);
+
+  // diskstats counts in 512 byte sectors, whatever the real sector size is
+  float const sector_size{512};
+  count = 0;
+  for (std::size_t i = 0; i < disks_.size(); ++i) {
+    LinuxParser::DiskDevice const& device = disks_[i];
+    LinuxParser::DiskDevice const* previous =
+        FindPrevious(prev_disks_, i, device.name);
+    if (previous == nullptr || device.io_ticks < previous->io_ticks ||
+        Hidden(device.name, true)) {
+      continue;
+    }
+    if (count == disk_rates_.size()) {
+      disk_rates_.emplace_back();
+    }
+    DiskRate& rate = disk_rates_[count++];
+    rate.name = device.name;
+    rate.iops = ((device.reads - previous->reads) +
+                 (device.writes - previous->writes)) /
+                seconds;
+    rate.read_bytes_per_second =
+        (device.sectors_read - previous->sectors_read) * sector_size / seconds;
+    rate.write_bytes_per_second =
+        (device.sectors_written - previous->sectors_written) * sector_size /
+        seconds;
+    rate.utilization = std::min(
+        1.0f, (device.io_ticks - previous->io_ticks) / (seconds * 1000));
+  }
+  disk_rates_.resize(count);
+}
+
+vector<NetRate>& Devices::Network() { return net_rates_; }
+
+vector<DiskRate>& Devices::Disks() { return disk_rates_; }
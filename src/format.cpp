@@ -29,4 +29,19 @@ string Format::ElapsedTime(long seconds) {
 
     return ssfh.str() + ":" + ssfm.str() + ":" + ssfs.str();
 
-}
\ No newline at end of file
+}
+
+// INPUT: number of bytes
+// OUTPUT: human readable size with one decimal, e.g. 1.5K, 230.0M
+string Format::Bytes(unsigned long long bytes) {
+    char const units[] = {'B', 'K', 'M', 'G', 'T'};
+    double value = bytes;
+    int unit = 0;
+    while (value >= 1024 && unit < 4) {
+        value /= 1024;
+        unit++;
+    }
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << value << units[unit];
+    return ss.str();
+}
@@ -1,5 +1,9 @@
 #include <dirent.h>
+#include <fcntl.h>
 #include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <string>
 #include <vector>
 #include <iostream>
@@ -11,6 +15,57 @@ using std::string;
 using std::to_string;
 using std::vector;
 
+namespace {
+/* Files that are parsed on every refresh are read into buffers which live
+   as long as the program, so once a buffer has grown to the size of its
+   file, reading and parsing it again does not allocate. */
+bool ReadFile(string const& path, vector<char>& buffer) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  if (buffer.size() < 4096) {
+    buffer.resize(4096);
+  }
+  std::size_t used{0};
+  ssize_t length;
+  while ((length = read(fd, buffer.data() + used, buffer.size() - 1 - used)) >
+         0) {
+    used += length;
+    if (used == buffer.size() - 1) {
+      buffer.resize(buffer.size() * 2);
+    }
+  }
+  close(fd);
+  buffer[used] = '\0';
+  return length == 0;
+}
+
+char const* NextLine(char const* line) {
+  while (*line != '\0' && *line != '\n') {
+    ++line;
+  }
+  return *line == '\n' ? line + 1 : line;
+}
+
+// reads a number and moves the cursor behind it
+unsigned long long ParseNumber(char const*& cursor) {
+  char* end;
+  unsigned long long value = std::strtoull(cursor, &end, 10);
+  cursor = end;
+  return value;
+}
+
+bool StartsWith(char const* line, char const* prefix) {
+  return std::strncmp(line, prefix, std::strlen(prefix)) == 0;
+}
+}  // namespace
+
+void LinuxParser::SetRootDirectory(string const& root) {
+  kProcDirectory = root + "/proc/";
+  kSysDirectory = root + "/sys/";
+}
+
 // DONE: An example of how to read data from the filesystem
 string LinuxParser::OperatingSystem() {
   string line;
@@ -70,17 +125,89 @@ vector<int> LinuxParser::Pids() {
   return pids;
 }
 
-// Linux stores memory utilization for the process in proc/[pid]/status
 float LinuxParser::MemoryUtilization() { 
-  /* Using template here which could potentially also be used elsewhere to
-     reduce code repetition overall. */
-  string memTotal = "MemTotal:";
-  string memFree = "MemFree:";
-  float valueMemTotal = findValueByKey<float>(memTotal, kMeminfoFilename);
-  float valueMemFree = findValueByKey<float>(memFree, kMeminfoFilename);
+  /* MemFree does not count buffers and page cache which the kernel gives
+     back as soon as it needs memory, MemAvailable does.
+     Memory utilization = (MemTotal - MemAvailable) / MemTotal */
+  MemInfo meminfo;
+  if (!ParseMemInfo(meminfo) || meminfo.total == 0) {
+    return 0;
+  }
+  return (float)(meminfo.total - meminfo.available) / meminfo.total;
+}
+
+bool LinuxParser::ParseMemInfo(MemInfo& meminfo) {
+  static vector<char> buffer;
+  static string path;
+  path.assign(kProcDirectory).append(kMeminfoFilename);
+  if (!ReadFile(path, buffer)) {
+    return false;
+  }
+  meminfo.available = -1;
+  for (char const* line = buffer.data(); *line != '\0';
+       line = NextLine(line)) {
+    char const* cursor = std::strchr(line, ':');
+    if (cursor == nullptr) {
+      break;
+    }
+    long value = ParseNumber(++cursor);
+    if (StartsWith(line, "MemTotal:")) {
+      meminfo.total = value;
+    } else if (StartsWith(line, "MemFree:")) {
+      meminfo.free = value;
+    } else if (StartsWith(line, "MemAvailable:")) {
+      meminfo.available = value;
+    } else if (StartsWith(line, "Buffers:")) {
+      meminfo.buffers = value;
+    } else if (StartsWith(line, "Cached:")) {
+      meminfo.cached = value;
+    } else if (StartsWith(line, "SwapTotal:")) {
+      meminfo.swap_total = value;
+    } else if (StartsWith(line, "SwapFree:")) {
+      meminfo.swap_free = value;
+    }
+  }
+  // kernels before 3.14 have no MemAvailable, estimate it
+  if (meminfo.available < 0) {
+    meminfo.available = meminfo.free + meminfo.buffers + meminfo.cached;
+  }
+  return true;
+}
+
+bool LinuxParser::ParseLoadAverage(LoadAverage& loadavg) {
+  static vector<char> buffer;
+  static string path;
+  path.assign(kProcDirectory).append(kLoadavgFilename);
+  if (!ReadFile(path, buffer)) {
+    return false;
+  }
+  return std::sscanf(buffer.data(), "%f %f %f", &loadavg.one, &loadavg.five,
+                     &loadavg.fifteen) == 3;
+}
 
-  // Memory utilization = (MemTotal - MemFree) / MemTotal
-  return (valueMemTotal - valueMemFree) / valueMemTotal;
+bool LinuxParser::ParsePressure(int resource, Pressure& pressure) {
+  static char const* const resources[] = {"cpu", "memory", "io"};
+  static vector<char> buffer;
+  static string path;
+  path.assign(kProcDirectory)
+      .append(kPressureDirectory)
+      .append(resources[resource]);
+  // kernels without CONFIG_PSI (or booted with psi=0) don't have the files
+  pressure.available = ReadFile(path, buffer);
+  if (!pressure.available) {
+    return false;
+  }
+  for (char const* line = buffer.data(); *line != '\0';
+       line = NextLine(line)) {
+    if (StartsWith(line, "some ")) {
+      std::sscanf(line, "some avg10=%f avg60=%f", &pressure.some_avg10,
+                  &pressure.some_avg60);
+    } else if (StartsWith(line, "full ")) {
+      std::sscanf(line, "full avg10=%f avg60=%f", &pressure.full_avg10,
+                  &pressure.full_avg60);
+    }
+  }
+  return true;
 }
 
 long LinuxParser::UpTime() {
@@ -95,6 +222,18 @@ long LinuxParser::UpTime() {
   return stol(seconds_up);
 }
 
+// same as UpTime(), but with the fraction of a second
+bool LinuxParser::ParseUpTime(double& seconds) {
+  static vector<char> buffer;
+  static string path;
+  path.assign(kProcDirectory).append(kUptimeFilename);
+  if (!ReadFile(path, buffer)) {
+    return false;
+  }
+  seconds = std::strtod(buffer.data(), nullptr);
+  return true;
+}
+
 long LinuxParser::Jiffies() { 
   return ActiveJiffies() + IdleJiffies();
 }
@@ -138,19 +277,70 @@ long LinuxParser::ActiveJiffies(int pid) {
 }
 
 long LinuxParser::ActiveJiffies() { 
-  // kUser_ + kNice_ + kSystem_ + kIRQ_ + kSoftIRQ_ + kSteal_
-  // It's inefficient calling CpuUtilization() here and also in IdleJiffies(). 
-  // Maybe this is the wrong approach, or there's a better approach at least?
-  // Comment from reviewer: would be detrimental to code-readability if CPuUtilization() is called
-  // just once.
-  vector<string> allJiffies = CpuUtilization();
-  return std::stol(allJiffies[kUser_]) + std::stol(allJiffies[kNice_]) + std::stol(allJiffies[kIRQ_]) + std::stol(allJiffies[kSoftIRQ_]) + std::stol(allJiffies[kSteal_]);
+  static StatInfo stat;
+  ParseStat(stat);
+  return stat.cpu.Active();
 }
 
 long LinuxParser::IdleJiffies() { 
+  static StatInfo stat;
+  ParseStat(stat);
+  return stat.cpu.Idle();
+}
+
+long LinuxParser::CpuTimes::Active() const {
+  // kUser_ + kNice_ + kSystem_ + kIRQ_ + kSoftIRQ_ + kSteal_
+  // (guest time is already accounted for in user and nice)
+  return jiffies[kUser_] + jiffies[kNice_] + jiffies[kSystem_] +
+         jiffies[kIRQ_] + jiffies[kSoftIRQ_] + jiffies[kSteal_];
+}
+
+long LinuxParser::CpuTimes::Idle() const {
   // kIdle_ + kIOwait_
-  vector<string> allJiffies = CpuUtilization();
-  return std::stol(allJiffies[kIdle_]) + std::stol(allJiffies[kIOwait_]);
+  return jiffies[kIdle_] + jiffies[kIOwait_];
+}
+
+long LinuxParser::CpuTimes::Total() const { return Active() + Idle(); }
+
+bool LinuxParser::ParseStat(StatInfo& stat) {
+  static vector<char> buffer;
+  static string path;
+  path.assign(kProcDirectory).append(kStatFilename);
+  if (!ReadFile(path, buffer)) {
+    return false;
+  }
+  stat.cores.clear();
+  for (char const* line = buffer.data(); *line != '\0';
+       line = NextLine(line)) {
+    char const* cursor = line;
+    if (StartsWith(line, "cpu")) {
+      // "cpu" is the sum over all cores, followed by one "cpuN" per core
+      CpuTimes* times = &stat.cpu;
+      cursor += 3;
+      if (*cursor != ' ') {
+        stat.cores.emplace_back();
+        times = &stat.cores.back();
+        times->id = ParseNumber(cursor);
+      }
+      for (int i = kUser_; i <= kGuestNice_; ++i) {
+        times->jiffies[i] = ParseNumber(cursor);
+      }
+    } else if (StartsWith(line, "ctxt ")) {
+      cursor += 5;
+      stat.context_switches = ParseNumber(cursor);
+    } else if (StartsWith(line, "intr ")) {
+      // the first number is the total, the rest are per interrupt line
+      cursor += 5;
+      stat.interrupts = ParseNumber(cursor);
+    } else if (StartsWith(line, "processes ")) {
+      cursor += 10;
+      stat.processes = ParseNumber(cursor);
+    } else if (StartsWith(line, "procs_running ")) {
+      cursor += 14;
+      stat.procs_running = ParseNumber(cursor);
+    }
+  }
+  return true;
 }
 
 vector<string> LinuxParser::CpuUtilization() { 
@@ -172,37 +362,236 @@ vector<string> LinuxParser::CpuUtilization() {
 }
 
 int LinuxParser::TotalProcesses() {
-  string line;
-  string key;
-  string number_processes = "0";
-  std::ifstream inputfilestream(kProcDirectory + kStatFilename);
-  if (inputfilestream.is_open()) {
-    while (std::getline(inputfilestream, line)) {
-      std::istringstream linestream(line);
-      linestream >> key;
-      if (key == "processes") {
-        linestream >> number_processes;
-      }
+  static StatInfo stat;
+  ParseStat(stat);
+  return stat.processes;
+}
+
+int LinuxParser::RunningProcesses() { 
+  static StatInfo stat;
+  ParseStat(stat);
+  return stat.procs_running;
+}
+
+bool LinuxParser::ParseNetDev(vector<NetDevice>& devices) {
+  static vector<char> buffer;
+  static string path;
+  path.assign(kProcDirectory).append(kNetDevFilename);
+  if (!ReadFile(path, buffer)) {
+    return false;
+  }
+  std::size_t count{0};
+  // the first two lines are the table header
+  char const* line = NextLine(NextLine(buffer.data()));
+  for (; *line != '\0'; line = NextLine(line)) {
+    char const* colon = std::strchr(line, ':');
+    if (colon == nullptr) {
+      break;
+    }
+    char const* name = line;
+    while (*name == ' ') {
+      ++name;
     }
+    // reuse the entries (and their name strings) of the previous refresh
+    if (count == devices.size()) {
+      devices.emplace_back();
+    }
+    NetDevice& device = devices[count++];
+    device.name.assign(name, colon - name);
+    char const* cursor = colon + 1;
+    // receive: bytes packets errs drop fifo frame compressed multicast
+    device.rx_bytes = ParseNumber(cursor);
+    for (int i = 0; i < 7; ++i) {
+      ParseNumber(cursor);
+    }
+    device.tx_bytes = ParseNumber(cursor);
   }
-  return std::stoi(number_processes);
+  devices.resize(count);
+  return true;
 }
 
-int LinuxParser::RunningProcesses() { 
-  string line;
-  string key;
-  string number_processes = "0";
-  std::ifstream inputfilestream(kProcDirectory + kStatFilename);
-  if (inputfilestream.is_open()) {
-    while (std::getline(inputfilestream, line)) {
-      std::istringstream linestream(line);
-      linestream >> key;
-      if (key == "procs_running") {
-        linestream >> number_processes;
+bool LinuxParser::ParseDiskStats(vector<DiskDevice>& devices) {
+  static vector<char> buffer;
+  static string path;
+  path.assign(kProcDirectory).append(kDiskstatsFilename);
+  if (!ReadFile(path, buffer)) {
+    return false;
+  }
+  std::size_t count{0};
+  for (char const* line = buffer.data(); *line != '\0';
+       line = NextLine(line)) {
+    // major minor name, followed by the counters
+    char const* cursor = line;
+    ParseNumber(cursor);
+    ParseNumber(cursor);
+    while (*cursor == ' ') {
+      ++cursor;
+    }
+    char const* name = cursor;
+    while (*cursor != ' ' && *cursor != '\n' && *cursor != '\0') {
+      ++cursor;
+    }
+    if (cursor == name) {
+      break;
+    }
+    if (count == devices.size()) {
+      devices.emplace_back();
+    }
+    DiskDevice& device = devices[count++];
+    device.name.assign(name, cursor - name);
+    device.reads = ParseNumber(cursor);
+    ParseNumber(cursor);  // reads merged
+    device.sectors_read = ParseNumber(cursor);
+    ParseNumber(cursor);  // ms reading
+    device.writes = ParseNumber(cursor);
+    ParseNumber(cursor);  // writes merged
+    device.sectors_written = ParseNumber(cursor);
+    ParseNumber(cursor);  // ms writing
+    ParseNumber(cursor);  // I/Os currently in progress
+    device.io_ticks = ParseNumber(cursor);
+  }
+  devices.resize(count);
+  return true;
+}
+
+bool LinuxParser::CpuNodes(vector<int>& cpu_nodes) {
+  cpu_nodes.clear();
+  // one directory "nodeN" per NUMA node, missing without CONFIG_NUMA
+  DIR* directory = opendir((kSysDirectory + kNodeDirectory).c_str());
+  if (directory == nullptr) {
+    return false;
+  }
+  struct dirent* file;
+  while ((file = readdir(directory)) != nullptr) {
+    char const* name = file->d_name;
+    if (!StartsWith(name, "node") || name[4] < '0' || name[4] > '9') {
+      continue;
+    }
+    char const* cursor = name + 4;
+    int node = ParseNumber(cursor);
+    // cpulist looks like "0-3,8-11"
+    string cpulist;
+    std::ifstream stream(kSysDirectory + kNodeDirectory + name + "/cpulist");
+    std::getline(stream, cpulist);
+    cursor = cpulist.c_str();
+    while (*cursor >= '0' && *cursor <= '9') {
+      std::size_t first = ParseNumber(cursor);
+      std::size_t last = first;
+      if (*cursor == '-') {
+        last = ParseNumber(++cursor);
+      }
+      if (last >= cpu_nodes.size()) {
+        cpu_nodes.resize(last + 1, -1);
+      }
+      for (std::size_t cpu = first; cpu <= last; ++cpu) {
+        cpu_nodes[cpu] = node;
       }
+      if (*cursor == ',') {
+        ++cursor;
+      }
+    }
+  }
+  closedir(directory);
+  return true;
+}
+
+bool LinuxParser::NodeMemory(int node, long& total_kb, long& free_kb) {
+  static vector<char> buffer;
+  static string path;
+  path.assign(kSysDirectory)
+      .append(kNodeDirectory)
+      .append("node")
+      .append(std::to_string(node))
+      .append(kMeminfoFilename);
+  if (!ReadFile(path, buffer)) {
+    return false;
+  }
+  // lines look like "Node 0 MemTotal:       16302412 kB"
+  for (char const* line = buffer.data(); *line != '\0';
+       line = NextLine(line)) {
+    char const* key = line + 5;  // behind "Node "
+    ParseNumber(key);
+    while (*key == ' ') {
+      ++key;
+    }
+    char const* cursor = std::strchr(key, ':');
+    if (cursor == nullptr) {
+      break;
+    }
+    long value = ParseNumber(++cursor);
+    if (StartsWith(key, "MemTotal:")) {
+      total_kb = value;
+    } else if (StartsWith(key, "MemFree:")) {
+      free_kb = value;
+    }
+  }
+  return true;
+}
+
+// loopback, bridges, veth pairs, tunnels, ... are all registered here
+bool LinuxParser::IsVirtualNetDevice(string const& name) {
+  return access((kSysDirectory + kVirtualNetDirectory + name).c_str(), F_OK) ==
+         0;
+}
+
+// loop, ram, zram, device mapper, ...
+bool LinuxParser::IsVirtualBlockDevice(string const& name) {
+  return access((kSysDirectory + kVirtualBlockDirectory + name).c_str(),
+                F_OK) == 0;
+}
+
+// only whole disks are listed in /sys/block, partitions are not
+bool LinuxParser::IsPartition(string const& name) {
+  return access((kSysDirectory + kBlockDirectory + name).c_str(), F_OK) != 0;
+}
+
+bool LinuxParser::ParseProcessStat(int pid, ProcessStat& stat) {
+  static vector<char> buffer;
+  static string path;
+  path.assign(kProcDirectory).append(std::to_string(pid)).append(kStatFilename);
+  if (!ReadFile(path, buffer)) {
+    return false;
+  }
+  // the command (field 2) may itself contain spaces and parentheses,
+  // so start counting fields after the last ')'
+  char const* cursor = std::strrchr(buffer.data(), ')');
+  if (cursor == nullptr || cursor[1] == '\0') {
+    return false;
+  }
+  cursor += 2;
+  stat.state = *cursor++;
+  // fields are numbered from 1 like in proc(5), field 3 was the state
+  for (int field = 4; field <= 39; ++field) {
+    char* end;
+    long value = std::strtol(cursor, &end, 10);
+    cursor = end;
+    switch (field) {
+      case 4:
+        stat.ppid = value;
+        break;
+      case 14:
+        stat.utime = value;
+        break;
+      case 15:
+        stat.stime = value;
+        break;
+      case 16:
+        stat.cutime = value;
+        break;
+      case 17:
+        stat.cstime = value;
+        break;
+      case 22:
+        stat.starttime = value;
+        break;
+      case 39:
+        stat.processor = value;
+        break;
+      default:
+        break;
     }
   }
-  return std::stoi(number_processes);
+  return true;
 }
 
 string LinuxParser::Command(int pid) { 
@@ -212,6 +601,61 @@ string LinuxParser::Command(int pid) {
 }
 
 
+// CPUs the process may run on, e.g. "0-3,8-11"
+string LinuxParser::CpusAllowed(int pid) {
+  return findValueByKey<string>("Cpus_allowed_list:",
+                                std::to_string(pid) + kStatusFilename);
+}
+
+// resident memory of the process on every NUMA node, in kB
+bool LinuxParser::NumaMemory(int pid, vector<long>& node_kb) {
+  static vector<char> buffer;
+  static string path;
+  path.assign(kProcDirectory).append(std::to_string(pid)).append(
+      kNumaMapsFilename);
+  node_kb.clear();
+  // numa_maps only exists on kernels built with CONFIG_NUMA
+  if (!ReadFile(path, buffer)) {
+    return false;
+  }
+  char const page_size_key[] = "kernelpagesize_kB=";
+  for (char const* line = buffer.data(); *line != '\0';
+       line = NextLine(line)) {
+    char const* end = std::strchr(line, '\n');
+    if (end == nullptr) {
+      end = line + std::strlen(line);
+    }
+    // "N<node>=<pages>" counts pages of the mapping's page size,
+    // which is given at the end of the line
+    char const* page_size = static_cast<char const*>(
+        memmem(line, end - line, page_size_key, sizeof(page_size_key) - 1));
+    if (page_size == nullptr) {
+      continue;
+    }
+    page_size += sizeof(page_size_key) - 1;
+    long const page_kb = ParseNumber(page_size);
+    for (char const* cursor = line; cursor < end; ++cursor) {
+      if (cursor[0] != ' ' || cursor[1] != 'N' || cursor[2] < '0' ||
+          cursor[2] > '9') {
+        continue;
+      }
+      cursor += 2;
+      std::size_t node = ParseNumber(cursor);
+      if (*cursor != '=') {
+        continue;
+      }
+      ++cursor;
+      long pages = ParseNumber(cursor);
+      if (node >= node_kb.size()) {
+        node_kb.resize(node + 1);
+      }
+      node_kb[node] += pages * page_kb;
+      --cursor;
+    }
+  }
+  return true;
+}
+
 string LinuxParser::Ram(int pid) { 
   string line;
   string key;
@@ -1,7 +1,39 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "linux_parser.h"
 #include "ncurses_display.h"
 #include "system.h"
 
-int main() {
+int main(int argc, char* argv[]) {
+  // --root DIR: read DIR/proc and DIR/sys instead, e.g. a synthetic tree
+  for (int i = 1; i + 1 < argc; ++i) {
+    if (std::strcmp(argv[i], "--root") == 0) {
+      LinuxParser::SetRootDirectory(argv[i + 1]);
+    }
+  }
   System system;
+  for (int i = 1; i < argc; ++i) {
+    /* --taskstats: also account for processes exiting between two
+       refreshes. The display clears the screen, so fail here instead of
+       silently running without the panel that was asked for. */
+    if (std::strcmp(argv[i], "--taskstats") == 0) {
+      if (!system.EnableExitAccounting()) {
+        std::cerr << "taskstats unavailable (needs CAP_NET_ADMIN)\n";
+        return EXIT_FAILURE;
+      }
+    }
+    // --all-devices: don't hide virtual devices and partitions
+    if (std::strcmp(argv[i], "--all-devices") == 0) {
+      system.Io().ShowAll(true);
+    }
+    // --interval-ms N: refresh every N milliseconds (at least 100)
+    if (std::strcmp(argv[i], "--interval-ms") == 0 && i + 1 < argc) {
+      system.Sampling().SetInterval(
+          std::chrono::milliseconds(std::atol(argv[++i])));
+    }
+  }
   NCursesDisplay::Display(system);
-}
\ No newline at end of file
+}
@@ -1,4 +1,5 @@
 #include <curses.h>
+#include <algorithm>
 #include <chrono>
 #include <string>
 #include <thread>
@@ -52,34 +53,296 @@ void NCursesDisplay::DisplaySystem(System& system, WINDOW* window) {
   wrefresh(window);
 }
 
+namespace {
+// "some 1.20% full 0.00%" using the 10 second average, or n/a without PSI
+string PressureText(LinuxParser::Pressure const& pressure) {
+  if (!pressure.available) {
+    return "n/a";
+  }
+  return "some " + to_string(pressure.some_avg10).substr(0, 4) + "%% full " +
+         to_string(pressure.full_avg10).substr(0, 4) + "%%";
+}
+}  // namespace
+
+// shows as many of its lines as fit into the window
+void NCursesDisplay::DisplayMetrics(System& system, WINDOW* window) {
+  int row{0};
+  int const lines{getmaxy(window) - 2};
+  LinuxParser::LoadAverage const& loadavg = system.LoadAverage();
+  LinuxParser::MemInfo const& meminfo = system.MemInfo();
+  // clear the lines first, the length of the values changes every refresh
+  for (int line = 1; line < getmaxy(window) - 1; ++line) {
+    wmove(window, line, 1);
+    wclrtoeol(window);
+  }
+  mvwprintw(window, ++row, 2,
+            ("Load: " + to_string(loadavg.one).substr(0, 4) + " " +
+             to_string(loadavg.five).substr(0, 4) + " " +
+             to_string(loadavg.fifteen).substr(0, 4))
+                .c_str());
+  mvwprintw(window, row, 30,
+            ("Ctxt/s: " + to_string(long(system.ContextSwitchesPerSecond())))
+                .c_str());
+  mvwprintw(window, row, 50,
+            ("Intr/s: " + to_string(long(system.InterruptsPerSecond())))
+                .c_str());
+  if (row == lines) {
+    wrefresh(window);
+    return;
+  }
+  mvwprintw(window, ++row, 2,
+            ("Available: " + Format::Bytes(meminfo.available * 1024ULL) +
+             " of " + Format::Bytes(meminfo.total * 1024ULL))
+                .c_str());
+  mvwprintw(window, row, 30,
+            ("Buff/Cache: " +
+             Format::Bytes((meminfo.buffers + meminfo.cached) * 1024ULL))
+                .c_str());
+  mvwprintw(window, row, 50,
+            ("Swap: " +
+             Format::Bytes((meminfo.swap_total - meminfo.swap_free) * 1024ULL) +
+             " of " + Format::Bytes(meminfo.swap_total * 1024ULL))
+                .c_str());
+  if (row == lines) {
+    wrefresh(window);
+    return;
+  }
+  mvwprintw(window, ++row, 2, "Pressure");
+  wattron(window, COLOR_PAIR(1));
+  mvwprintw(window, row, 12,
+            ("cpu: " +
+             PressureText(system.Pressure(LinuxParser::kPressureCpu_)))
+                .c_str());
+  if (row == lines) {
+    wattroff(window, COLOR_PAIR(1));
+    wrefresh(window);
+    return;
+  }
+  mvwprintw(window, ++row, 12,
+            ("mem: " +
+             PressureText(system.Pressure(LinuxParser::kPressureMemory_)))
+                .c_str());
+  mvwprintw(window, row, 44,
+            ("io: " + PressureText(system.Pressure(LinuxParser::kPressureIO_)))
+                .c_str());
+  wattroff(window, COLOR_PAIR(1));
+  wrefresh(window);
+}
+
+// network interfaces on the left, block devices on the right
+void NCursesDisplay::DisplayDevices(Devices& devices, WINDOW* window, int n) {
+  int row{0};
+  int const iface_column{2};
+  int const rx_column{14};
+  int const tx_column{24};
+  int const disk_column{34};
+  int const iops_column{44};
+  int const read_column{51};
+  int const write_column{60};
+  int const util_column{69};
+  wattron(window, COLOR_PAIR(2));
+  mvwprintw(window, ++row, iface_column, "IFACE");
+  mvwprintw(window, row, rx_column, "RX/s");
+  mvwprintw(window, row, tx_column, "TX/s");
+  mvwprintw(window, row, disk_column, "DISK");
+  mvwprintw(window, row, iops_column, "IOPS");
+  mvwprintw(window, row, read_column, "READ/s");
+  mvwprintw(window, row, write_column, "WRITE/s");
+  mvwprintw(window, row, util_column, "UTIL[%%]");
+  wattroff(window, COLOR_PAIR(2));
+  std::vector<NetRate>& network = devices.Network();
+  std::vector<DiskRate>& disks = devices.Disks();
+  for (int i = 0; i < n; ++i) {
+    wmove(window, ++row, 1);
+    wclrtoeol(window);
+    if (i < int(network.size())) {
+      string name = network[i].name.substr(0, rx_column - iface_column - 1);
+      mvwprintw(window, row, iface_column, "%s", name.c_str());
+      mvwprintw(window, row, rx_column,
+                Format::Bytes(network[i].rx_bytes_per_second).c_str());
+      mvwprintw(window, row, tx_column,
+                Format::Bytes(network[i].tx_bytes_per_second).c_str());
+    }
+    if (i < int(disks.size())) {
+      string name = disks[i].name.substr(0, iops_column - disk_column - 1);
+      mvwprintw(window, row, disk_column, "%s", name.c_str());
+      mvwprintw(window, row, iops_column,
+                to_string(long(disks[i].iops)).c_str());
+      mvwprintw(window, row, read_column,
+                Format::Bytes(disks[i].read_bytes_per_second).c_str());
+      mvwprintw(window, row, write_column,
+                Format::Bytes(disks[i].write_bytes_per_second).c_str());
+      mvwprintw(window, row, util_column,
+                to_string(disks[i].utilization * 100).substr(0, 4).c_str());
+    }
+  }
+}
+
 void NCursesDisplay::DisplayProcesses(std::vector<Process>& processes,
-                                      WINDOW* window, int n) {
+                                      WINDOW* window, int n, bool numa) {
   int row{0};
   int const pid_column{2};
   int const user_column{9};
   int const cpu_column{16};
   int const ram_column{26};
   int const time_column{35};
-  int const command_column{46};
+  /* The placement columns are added one by one as long as the command
+     keeps at least min_command_width columns; NUMA only when asked for. */
+  int const width{getmaxx(window)};
+  int const min_command_width{24};
+  int column{46};
+  auto fits = [&](int column_width) {
+    return width - 1 - (column + column_width) >= min_command_width;
+  };
+  int const last_cpu_column{column};
+  bool const show_last_cpu{fits(4)};
+  if (show_last_cpu) {
+    column += 4;
+  }
+  int const affinity_column{column};
+  bool const show_affinity{fits(12)};
+  if (show_affinity) {
+    column += 12;
+  }
+  int const numa_column{column};
+  bool const show_numa{numa && fits(20)};
+  if (show_numa) {
+    column += 20;
+  }
+  int const command_column{column};
   wattron(window, COLOR_PAIR(2));
   mvwprintw(window, ++row, pid_column, "PID");
   mvwprintw(window, row, user_column, "USER");
   mvwprintw(window, row, cpu_column, "CPU[%%]");
   mvwprintw(window, row, ram_column, "RAM[MB]");
   mvwprintw(window, row, time_column, "TIME+");
+  if (show_last_cpu) {
+    mvwprintw(window, row, last_cpu_column, "P");
+  }
+  if (show_affinity) {
+    mvwprintw(window, row, affinity_column, "AFFINITY");
+  }
+  if (show_numa) {
+    mvwprintw(window, row, numa_column, "NUMA");
+  }
   mvwprintw(window, row, command_column, "COMMAND");
   wattroff(window, COLOR_PAIR(2));
   int const num_processes = int(processes.size()) > n ? n : processes.size();
   for (int i = 0; i < num_processes; ++i) {
-    mvwprintw(window, ++row, pid_column, to_string(processes[i].Pid()).c_str());
-    mvwprintw(window, row, user_column, processes[i].User().c_str());
+    // clear the row first, the values have a different length every refresh
+    wmove(window, ++row, 1);
+    wclrtoeol(window);
+    mvwprintw(window, row, pid_column, to_string(processes[i].Pid()).c_str());
+    mvwprintw(window, row, user_column, "%s", processes[i].User().c_str());
     float cpu = processes[i].CpuUtilization() * 100;
     mvwprintw(window, row, cpu_column, to_string(cpu).substr(0, 4).c_str());
     mvwprintw(window, row, ram_column, processes[i].Ram().c_str());
     mvwprintw(window, row, time_column,
               Format::ElapsedTime(processes[i].UpTime()).c_str());
-    mvwprintw(window, row, command_column,
-              processes[i].Command().substr(0, window->_maxx - 46).c_str());
+    if (show_last_cpu) {
+      mvwprintw(window, row, last_cpu_column,
+                to_string(processes[i].LastCpu()).c_str());
+    }
+    if (show_affinity) {
+      string affinity = processes[i].CpusAllowed();
+      mvwprintw(window, row, affinity_column, "%s",
+                affinity.substr(0, numa_column - affinity_column - 1).c_str());
+    }
+    if (show_numa) {
+      // resident memory per node, e.g. "0:1.2G 1:300.0M"
+      string placement;
+      std::vector<long> node_kb = processes[i].NumaMemory();
+      for (std::size_t node = 0; node < node_kb.size(); ++node) {
+        if (node_kb[node] > 0) {
+          placement += to_string(node) + ":" +
+                       Format::Bytes(node_kb[node] * 1024ULL) + " ";
+        }
+      }
+      mvwprintw(window, row, numa_column, "%s",
+                placement.substr(0, command_column - numa_column - 1).c_str());
+    }
+    mvwprintw(window, row, command_column, "%s",
+              processes[i]
+                  .Command()
+                  .substr(0, window->_maxx - command_column)
+                  .c_str());
+  }
+}
+
+// CPU and memory of every NUMA node, as many nodes as fit into the window
+void NCursesDisplay::DisplayNuma(NumaNodes& numa, WINDOW* window) {
+  int row{0};
+  int const lines{getmaxy(window) - 2};
+  // the progress bar ends at column 72, the memory text needs ~35 more
+  bool const progress_bar{getmaxx(window) >= 110};
+  for (NodeLoad const& node : numa.Nodes()) {
+    if (row == lines) {
+      break;
+    }
+    wmove(window, ++row, 1);
+    wclrtoeol(window);
+    mvwprintw(window, row, 2, "Node %d:", node.id);
+    int memory_column{24};
+    wattron(window, COLOR_PAIR(1));
+    if (progress_bar) {
+      wmove(window, row, 10);
+      wprintw(window, ProgressBar(node.utilization).c_str());
+      memory_column = 75;
+    } else {
+      mvwprintw(window, row, 10, "CPU: %s%%",
+                to_string(node.utilization * 100).substr(0, 4).c_str());
+    }
+    wattroff(window, COLOR_PAIR(1));
+    mvwprintw(window, row, memory_column, "%s",
+              ("Mem: " +
+               Format::Bytes((node.mem_total_kb - node.mem_free_kb) * 1024ULL) +
+               " of " + Format::Bytes(node.mem_total_kb * 1024ULL) + ", " +
+               to_string(node.cpus) + " CPUs")
+                  .c_str());
+  }
+}
+
+// short-lived processes reported by taskstats, grouped by parent and command
+void NCursesDisplay::DisplayExited(std::vector<ExitedGroup>& groups,
+                                   float total_cpu, bool complete,
+                                   WINDOW* window, int n) {
+  int row{0};
+  int const ppid_column{2};
+  int const count_column{9};
+  int const cpu_column{16};
+  int const read_column{26};
+  int const write_column{35};
+  int const command_column{46};
+  wattron(window, COLOR_PAIR(2));
+  mvwprintw(window, ++row, ppid_column, "PPID");
+  mvwprintw(window, row, count_column, "EXITS");
+  mvwprintw(window, row, cpu_column, "CPU[%%]");
+  mvwprintw(window, row, read_column, "READ");
+  mvwprintw(window, row, write_column, "WRITE");
+  // records that were left out make the total a lower bound
+  string header{"COMMAND (exited: " + string(complete ? "" : ">") +
+                to_string(total_cpu * 100).substr(0, 4) + "% of total CPU)"};
+  mvwprintw(window, row, command_column, "%s",
+            header.substr(0, getmaxx(window) - 1 - command_column).c_str());
+  wattroff(window, COLOR_PAIR(2));
+  int const num_groups = int(groups.size()) > n ? n : groups.size();
+  for (int i = 0; i < num_groups; ++i) {
+    // clear the row first, the number of groups changes every refresh
+    wmove(window, ++row, 1);
+    wclrtoeol(window);
+    mvwprintw(window, row, ppid_column, to_string(groups[i].ppid).c_str());
+    mvwprintw(window, row, count_column, to_string(groups[i].count).c_str());
+    float cpu = groups[i].cpu_load * 100;
+    mvwprintw(window, row, cpu_column, to_string(cpu).substr(0, 4).c_str());
+    mvwprintw(window, row, read_column,
+              Format::Bytes(groups[i].read_bytes).c_str());
+    mvwprintw(window, row, write_column,
+              Format::Bytes(groups[i].write_bytes).c_str());
+    mvwprintw(window, row, command_column, "%s", groups[i].command.c_str());
+  }
+  for (int i = num_groups; i < n; ++i) {
+    wmove(window, ++row, 1);
+    wclrtoeol(window);
   }
 }
 
@@ -89,22 +352,111 @@ void NCursesDisplay::Display(System& system, int n) {
   cbreak();       // terminate ncurses on ctrl + c
   start_color();  // enable color
 
+  // everything that is displayed is also sampled on every refresh
+  if (system.Sampling().HotCount() < n) {
+    system.Sampling().SetHotCount(n);
+  }
+
   int x_max{getmaxx(stdscr)};
-  WINDOW* system_window = newwin(9, x_max - 1, 0, 0);
-  WINDOW* process_window =
-      newwin(3 + n, x_max - 1, system_window->_maxy + 1, 0);
+  int y_max{getmaxy(stdscr)};
+  /* The process list is the main view, it gets its rows first. The other
+     panels share the rest of the screen in order of importance and are
+     shrunk or left out when there is no room for them. */
+  int const system_height{9};
+  int const process_height{std::max(3, std::min(3 + n, y_max - system_height))};
+  n = process_height - 3;
+  int spare{y_max - system_height - process_height};
+  auto take = [&spare](int wanted, int minimum) {
+    int height = spare >= minimum ? std::min(wanted, spare) : 0;
+    spare -= height;
+    return height;
+  };
+  int const num_devices{4};
+  /* Metrics and devices need about 80 columns each, on wide terminals they
+     are shown side by side and share their rows. */
+  bool const side_by_side{x_max >= 2 * 82};
+  int metrics_height{0};
+  int devices_height{0};
+  if (side_by_side) {
+    metrics_height = devices_height = take(3 + num_devices, 4);
+  } else {
+    metrics_height = take(6, 3);
+    devices_height = take(3 + num_devices, 4);
+  }
+  // the per node panel only makes sense with more than one node
+  int const num_nodes{system.Numa().Count()};
+  int const numa_height{num_nodes > 1 ? take(2 + num_nodes, 3) : 0};
+  int const exited_height{
+      system.ExitAccountingEnabled() ? take(3 + n / 2, 4) : 0};
+
+  // the windows are stacked from the top of the screen
+  int top{0};
+  WINDOW* system_window = newwin(system_height, x_max - 1, top, 0);
+  top += system_height;
+  WINDOW* metrics_window = nullptr;
+  WINDOW* devices_window = nullptr;
+  if (side_by_side && metrics_height > 0) {
+    metrics_window = newwin(metrics_height, x_max / 2, top, 0);
+    devices_window =
+        newwin(devices_height, x_max - 1 - x_max / 2, top, x_max / 2);
+    top += metrics_height;
+  } else {
+    if (metrics_height > 0) {
+      metrics_window = newwin(metrics_height, x_max - 1, top, 0);
+      top += metrics_height;
+    }
+    if (devices_height > 0) {
+      devices_window = newwin(devices_height, x_max - 1, top, 0);
+      top += devices_height;
+    }
+  }
+  WINDOW* numa_window = nullptr;
+  if (numa_height > 0) {
+    numa_window = newwin(numa_height, x_max - 1, top, 0);
+    top += numa_height;
+  }
+  WINDOW* process_window = newwin(process_height, x_max - 1, top, 0);
+  top += process_height;
+  WINDOW* exited_window = nullptr;
+  if (exited_height > 0) {
+    exited_window = newwin(exited_height, x_max - 1, top, 0);
+  }
 
   while (1) {
     init_pair(1, COLOR_BLUE, COLOR_BLACK);
     init_pair(2, COLOR_GREEN, COLOR_BLACK);
+    system.Refresh();
     box(system_window, 0, 0);
-    box(process_window, 0, 0);
     DisplaySystem(system, system_window);
-    DisplayProcesses(system.Processes(), process_window, n);
+    if (metrics_window != nullptr) {
+      DisplayMetrics(system, metrics_window);
+      box(metrics_window, 0, 0);
+      wrefresh(metrics_window);
+    }
+    if (devices_window != nullptr) {
+      DisplayDevices(system.Io(), devices_window, devices_height - 3);
+      box(devices_window, 0, 0);
+      wrefresh(devices_window);
+    }
+    if (numa_window != nullptr) {
+      DisplayNuma(system.Numa(), numa_window);
+      box(numa_window, 0, 0);
+      wrefresh(numa_window);
+    }
+    DisplayProcesses(system.Processes(), process_window, n, num_nodes > 1);
+    box(process_window, 0, 0);
+    if (exited_window != nullptr) {
+      std::vector<ExitedGroup>& exited = system.ExitedProcesses();
+      DisplayExited(exited, system.ExitedCpuUtilization(),
+                    system.ExitedProcessesComplete(), exited_window,
+                    exited_height - 3);
+      box(exited_window, 0, 0);
+      wrefresh(exited_window);
+    }
     wrefresh(system_window);
     wrefresh(process_window);
     refresh();
-    std::this_thread::sleep_for(std::chrono::seconds(1));
+    std::this_thread::sleep_for(system.Sampling().Interval());
   }
   endwin();
 }
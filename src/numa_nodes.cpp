@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <vector>
+
+#include "linux_parser.h"
+#include "numa_nodes.h"
+
+using std::vector;
+
+void NumaNodes::Load() {
+  loaded = true;
+  if (!LinuxParser::CpuNodes(cpu_nodes_)) {
+    return;
+  }
+  for (int node : cpu_nodes_) {
+    if (node < 0) {
+      continue;
+    }
+    if (node >= int(node_index_.size())) {
+      node_index_.resize(node + 1, -1);
+    }
+    if (node_index_[node] < 0) {
+      node_index_[node] = nodes_.size();
+      nodes_.emplace_back();
+      nodes_.back().id = node;
+    }
+    nodes_[node_index_[node]].cpus++;
+  }
+  // CpuNodes() lists the nodes in directory order
+  std::sort(nodes_.begin(), nodes_.end(),
+            [](NodeLoad const& a, NodeLoad const& b) { return a.id < b.id; });
+  for (std::size_t i = 0; i < nodes_.size(); ++i) {
+    node_index_[nodes_[i].id] = i;
+  }
+  prev_active_.resize(cpu_nodes_.size());
+  prev_total_.resize(cpu_nodes_.size());
+  active_delta_.resize(nodes_.size());
+  total_delta_.resize(nodes_.size());
+}
+
+void NumaNodes::Update(vector<LinuxParser::CpuTimes> const& cores) {
+  if (!loaded) {
+    Load();
+  }
+  if (nodes_.size() <= 1) {
+    return;
+  }
+  std::fill(active_delta_.begin(), active_delta_.end(), 0);
+  std::fill(total_delta_.begin(), total_delta_.end(), 0);
+  for (LinuxParser::CpuTimes const& core : cores) {
+    if (core.id < 0 || core.id >= int(cpu_nodes_.size()) ||
+        cpu_nodes_[core.id] < 0) {
+      continue;
+    }
+    int const node = node_index_[cpu_nodes_[core.id]];
+    long const active = core.Active();
+    long const total = core.Total();
+    // no delta on the first refresh
+    if (prev_total_[core.id] != 0) {
+      active_delta_[node] += active - prev_active_[core.id];
+      total_delta_[node] += total - prev_total_[core.id];
+    }
+    prev_active_[core.id] = active;
+    prev_total_[core.id] = total;
+  }
+  for (std::size_t i = 0; i < nodes_.size(); ++i) {
+    NodeLoad& node = nodes_[i];
+    if (total_delta_[i] > 0) {
+      node.utilization = (float)active_delta_[i] / total_delta_[i];
+    }
+    LinuxParser::NodeMemory(node.id, node.mem_total_kb, node.mem_free_kb);
+  }
+}
+
+int NumaNodes::Count() {
+  if (!loaded) {
+    Load();
+  }
+  return nodes_.size();
+}
+
+vector<NodeLoad>& NumaNodes::Nodes() { return nodes_; }
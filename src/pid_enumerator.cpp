@@ -0,0 +1,87 @@
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "linux_parser.h"
+#include "pid_enumerator.h"
+
+using std::vector;
+
+namespace {
+// layout of the records returned by getdents64(2), glibc has no declaration
+struct linux_dirent64 {
+  std::uint64_t d_ino;
+  std::int64_t d_off;
+  unsigned short d_reclen;
+  unsigned char d_type;
+  char d_name[];
+};
+}  // namespace
+
+PidEnumerator::PidEnumerator() : buffer(256 * 1024) {}
+
+PidEnumerator::~PidEnumerator() {
+  if (directory_fd >= 0) {
+    close(directory_fd);
+  }
+}
+
+bool PidEnumerator::Scan(vector<int>& pids, vector<unsigned long>& inodes) {
+  pids.clear();
+  inodes.clear();
+  if (directory_fd < 0) {
+    directory_fd = open(LinuxParser::kProcDirectory.c_str(),
+                        O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (directory_fd < 0) {
+      return false;
+    }
+  } else if (lseek(directory_fd, 0, SEEK_SET) < 0) {
+    return false;
+  }
+
+  long length;
+  while ((length = syscall(SYS_getdents64, directory_fd, buffer.data(),
+                           buffer.size())) > 0) {
+    for (long offset = 0; offset < length;) {
+      auto entry =
+          reinterpret_cast<linux_dirent64 const*>(buffer.data() + offset);
+      offset += entry->d_reclen;
+      // Is this a directory whose name is a number?
+      if (entry->d_type != DT_DIR && entry->d_type != DT_UNKNOWN) {
+        continue;
+      }
+      int pid{0};
+      char const* name = entry->d_name;
+      for (; *name >= '0' && *name <= '9'; ++name) {
+        pid = pid * 10 + (*name - '0');
+      }
+      if (*name == '\0' && name != entry->d_name) {
+        pids.push_back(pid);
+        inodes.push_back(entry->d_ino);
+      }
+    }
+  }
+  if (length < 0) {
+    return false;
+  }
+  // /proc lists processes in ascending order already, so this is just a
+  // linear check in practice
+  if (!std::is_sorted(pids.begin(), pids.end())) {
+    vector<std::pair<int, unsigned long>> entries;
+    for (std::size_t i = 0; i < pids.size(); ++i) {
+      entries.emplace_back(pids[i], inodes[i]);
+    }
+    std::sort(entries.begin(), entries.end());
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+      pids[i] = entries[i].first;
+      inodes[i] = entries[i].second;
+    }
+  }
+  return true;
+}
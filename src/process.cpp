@@ -27,16 +27,93 @@ float Process::getCpuLoad() const {
     return cpu_load;
 }
 
-void Process::CalcCpuLoad() {
-    // total time CPU has been busy with this process
-    float process_totaltime = (float) LinuxParser::ActiveJiffies(Pid()) / (float) sysconf(_SC_CLK_TCK);  
+bool Process::CalcCpuLoad(double system_uptime) {
+    // one read of /proc/[pid]/stat per sample
+    LinuxParser::ProcessStat stat;
+    if (!LinuxParser::ParseProcessStat(Pid(), stat)) {
+        return false;
+    }
+    double const ticks = sysconf(_SC_CLK_TCK);
+    // total time CPU has been busy with this process. Time of waited-for
+    // children is left out, it was already shown while they were running.
+    double process_totaltime = (stat.utime + stat.stime) / ticks;
+    /* A different start time means the PID was reused by a new process:
+       forget the samples of the old one, start over with a first sample
+       and sample it on every refresh until it has shown to be idle. */
+    if (stat.starttime != start_jiffies) {
+        process_totaltime_old = 0;
+        process_uptime_old = 0;
+        idle_samples = 0;
+        sample_interval = 1;
+        start_jiffies = stat.starttime;
+    }
     // start time of the process in seconds
-    float process_startime = (float) LinuxParser::UpTime(Pid()); 
-    // uptime of the system in seconds
-    float system_uptime = (float) LinuxParser::UpTime(); 
-    float process_uptime = system_uptime - process_startime;
-    
-    cpu_load = process_totaltime / process_uptime;
+    start_time = stat.starttime / ticks;
+    last_cpu = stat.processor;
+    double process_uptime = system_uptime - stat.starttime / ticks;
+
+    if (process_uptime_old == 0) {
+        // first sample: nothing to compare with, use the average since start
+        cpu_load = process_uptime > 0 ? process_totaltime / process_uptime : 0;
+    } else if (process_uptime > process_uptime_old) {
+        // CPU time used since the previous sample
+        cpu_load = (process_totaltime - process_totaltime_old) / (process_uptime - process_uptime_old);
+    }
+    // a process that neither ran nor got CPU time since the last sample is idle
+    if (process_uptime_old != 0 && process_totaltime == process_totaltime_old && stat.state != 'R') {
+        idle_samples++;
+    } else {
+        idle_samples = 0;
+    }
+    process_totaltime_old = process_totaltime;
+    process_uptime_old = process_uptime;
+    return true;
+}
+
+// CPU seconds of the process at its last sample, -1 if never sampled
+double Process::SampledCpuTime() const {
+    return process_uptime_old == 0 ? -1 : process_totaltime_old;
+}
+
+int Process::LastCpu() const {
+    return last_cpu;
+}
+
+/* Affinity and NUMA placement are read when they are displayed, i.e. only
+   for the top processes, not on every sample. */
+string Process::CpusAllowed() {
+    return LinuxParser::CpusAllowed(Pid());
+}
+
+vector<long> Process::NumaMemory() {
+    vector<long> node_kb;
+    LinuxParser::NumaMemory(Pid(), node_kb);
+    return node_kb;
+}
+
+int Process::IdleSamples() const {
+    return idle_samples;
+}
+
+long Process::NextSample() const {
+    return next_sample;
+}
+
+int Process::SampleInterval() const {
+    return sample_interval;
+}
+
+unsigned long Process::ProcInode() const {
+    return proc_inode;
+}
+
+void Process::setProcInode(unsigned long inode) {
+    proc_inode = inode;
+}
+
+void Process::setSchedule(long next_sample_in, int interval) {
+    next_sample = next_sample_in;
+    sample_interval = interval;
 }
 
 float Process::CpuUtilization() { 
@@ -67,7 +144,7 @@ long int Process::UpTime() {
     // Note: "long and long int are identical" (from stackoverflow)
     // LinuxParser::UpTime(int pid) returns long and this method returns long int.
     // (system uptime) - (the time the process started after system boot) 
-    return LinuxParser::UpTime() - LinuxParser::UpTime(Pid());
+    return LinuxParser::UpTime() - start_time;
 }
 
 bool Process::operator<(Process const& a) const {
@@ -7,16 +7,20 @@
 using std::string;
 using std::vector;
 
-float Processor::Utilization() {
+void Processor::Update(LinuxParser::CpuTimes const& times) {
     /* reporting the current utilization of the processor, 
        rather than the long-term average utilization since
        boot: Delta (Active Time Units) / Delta (Total Time Units). */
-    long activeJiffies = LinuxParser::ActiveJiffies();
-    long jiffies = LinuxParser::Jiffies();
-    float utilization = ((float) activeJiffies - prevActiveJiffies) / ((float) jiffies - prevJiffies);
-    // or is a single explicit cast after the division sufficient?
-    // float utilization = (float) (activeJiffies - prevActiveJiffies) / (jiffies - prevJiffies);
+    long activeJiffies = times.Active();
+    long jiffies = times.Total();
+    if (jiffies != prevJiffies) {
+        utilization = (float) (activeJiffies - prevActiveJiffies) / (jiffies - prevJiffies);
+    }
     prevActiveJiffies = activeJiffies;
     prevJiffies = jiffies;
+}
+
+// utilization between the last two calls of Update()
+float Processor::Utilization() {
     return utilization;
-}
\ No newline at end of file
+}
@@ -0,0 +1,56 @@
+#include <algorithm>
+#include <chrono>
+
+#include "process.h"
+#include "scheduler.h"
+
+constexpr int Scheduler::kIdleSamples;
+constexpr std::chrono::milliseconds Scheduler::kMinInterval;
+
+void Scheduler::SetInterval(std::chrono::milliseconds interval_in) {
+    interval = std::max(interval_in, kMinInterval);
+    // an idle process is sampled at least every ~30 seconds, whatever the
+    // refresh interval is
+    max_interval = std::max<long>(1, std::chrono::seconds(32) / interval);
+}
+
+std::chrono::milliseconds Scheduler::Interval() const {
+    return interval;
+}
+
+void Scheduler::SetHotCount(int count) {
+    hot_count = std::max(count, 0);
+}
+
+int Scheduler::HotCount() const {
+    return hot_count;
+}
+
+void Scheduler::BeginTick() {
+    tick++;
+}
+
+bool Scheduler::Due(Process const& process) const {
+    return process.NextSample() <= tick;
+}
+
+// called after a process was sampled on this tick
+void Scheduler::Reschedule(Process& process, bool hot) const {
+    int next_interval = 1;
+    if (!hot && process.IdleSamples() >= kIdleSamples) {
+        next_interval = std::min(process.SampleInterval() * 2, max_interval);
+    }
+    process.setSchedule(tick + next_interval, next_interval);
+}
+
+// a process that just made it into the top-N is sampled on the next tick
+void Scheduler::Promote(Process& process) const {
+    if (process.NextSample() > tick + 1) {
+        process.setSchedule(tick + 1, 1);
+    }
+}
+
+// a process that may have changed is sampled on this tick already
+void Scheduler::Wake(Process& process) const {
+    process.setSchedule(tick, 1);
+}
@@ -1,4 +1,5 @@
 #include <unistd.h>
+#include <algorithm>
 #include <cstddef>
 #include <set>
 #include <string>
@@ -16,25 +17,104 @@ using std::size_t;
 using std::string;
 using std::vector;
 
+void System::Refresh() {
+    /* /proc/stat is read only once per refresh, the CPU bar, the process
+       counts and the rates below are all taken from the same snapshot. */
+    unsigned long long prev_context_switches = stat_.context_switches;
+    unsigned long long prev_interrupts = stat_.interrupts;
+    auto now = std::chrono::steady_clock::now();
+    if (LinuxParser::ParseStat(stat_)) {
+        cpu_.Update(stat_.cpu);
+        numa_.Update(stat_.cores);
+        float seconds = std::chrono::duration<float>(now - last_refresh_).count();
+        // no rates on the very first refresh, there is nothing to compare with
+        if (prev_context_switches != 0 && seconds > 0) {
+            context_switches_per_second_ = (stat_.context_switches - prev_context_switches) / seconds;
+            interrupts_per_second_ = (stat_.interrupts - prev_interrupts) / seconds;
+        }
+    }
+    last_refresh_ = now;
+    LinuxParser::ParseUpTime(uptime_);
+    LinuxParser::ParseMemInfo(meminfo_);
+    LinuxParser::ParseLoadAverage(loadavg_);
+    for (int resource = LinuxParser::kPressureCpu_; resource <= LinuxParser::kPressureIO_; resource++) {
+        LinuxParser::ParsePressure(resource, pressure_[resource]);
+    }
+    io_.Update();
+}
+
 Processor& System::Cpu() { return cpu_; }
 
+Devices& System::Io() { return io_; }
+
+Scheduler& System::Sampling() { return scheduler_; }
+
+NumaNodes& System::Numa() { return numa_; }
+
 vector<Process>& System::Processes() { 
-    processes_.clear();
-    // First get the IDs of all the processes
-    vector<int> processPIDs = LinuxParser::Pids();
-    for (int pid : processPIDs) {
-        // create a new process for every process ID
-        Process process;
-        // set its ID to the corresponding ID from LinuxParser
-        process.setPID(pid);
-        process.CalcCpuLoad();
-        // push the process to the vector of processes
-        // emplace_back() is more efficent than push_back()
-        processes_.emplace_back(process);
+    scheduler_.BeginTick();
+    // First get the IDs of all the processes, in the same order as the table
+    pid_enumerator_.Scan(pids_, inodes_);
+
+    /* Collect the processes that exited since the last refresh while the
+       table still has their last samples, so the exit records only add
+       the CPU time that was not shown in the process list yet. */
+    taskstats_.Poll([this](int pid) {
+        auto entry = std::lower_bound(table_.begin(), table_.end(), pid,
+                                      [](Process const& p, int id) { return p.Pid() < id; });
+        return entry != table_.end() && entry->Pid() == pid ? entry->SampledCpuTime() : -1.0;
+    });
+
+    /* Merge them with the table of the last refresh: processes that are
+       still alive keep their samples, new ones are added and processes
+       that are gone are dropped. */
+    next_table_.clear();
+    auto existing = table_.begin();
+    for (std::size_t i = 0; i < pids_.size(); ++i) {
+        int const pid = pids_[i];
+        while (existing != table_.end() && existing->Pid() < pid) {
+            ++existing;
+        }
+        if (existing != table_.end() && existing->Pid() == pid) {
+            next_table_.emplace_back(*existing);
+            // the PID may have been reused, CalcCpuLoad() finds out
+            if (existing->ProcInode() != inodes_[i]) {
+                scheduler_.Wake(next_table_.back());
+            }
+        } else {
+            // create a new process for every new process ID
+            Process process;
+            process.setPID(pid);
+            next_table_.emplace_back(process);
+        }
+        next_table_.back().setProcInode(inodes_[i]);
     }
+    std::swap(table_, next_table_);
 
-    // sort the processes according to cpu utilization
-    std::sort(processes_.begin(), processes_.end());
+    // only the processes that are due are sampled on this refresh
+    for (Process& process : table_) {
+        if (scheduler_.Due(process) && process.CalcCpuLoad(uptime_)) {
+            bool hot = std::binary_search(hot_pids_.begin(), hot_pids_.end(), process.Pid());
+            scheduler_.Reschedule(process, hot);
+        }
+    }
+
+    // sort the top processes according to cpu utilization
+    std::size_t top = std::min<std::size_t>(scheduler_.HotCount(), table_.size());
+    processes_.resize(top);
+    std::partial_sort_copy(table_.begin(), table_.end(), processes_.begin(), processes_.end());
+
+    // the top processes stay hot, i.e. they are sampled on every refresh
+    hot_pids_.clear();
+    for (Process const& process : processes_) {
+        hot_pids_.push_back(process.Pid());
+    }
+    std::sort(hot_pids_.begin(), hot_pids_.end());
+    for (int pid : hot_pids_) {
+        auto entry = std::lower_bound(table_.begin(), table_.end(), pid,
+                                      [](Process const& p, int id) { return p.Pid() < id; });
+        scheduler_.Promote(*entry);
+    }
 
     return processes_;
 }
@@ -44,7 +124,30 @@ std::string System::Kernel() {
 }
 
 float System::MemoryUtilization() { 
-    return LinuxParser::MemoryUtilization();
+    if (meminfo_.total == 0) {
+        return 0;
+    }
+    return (float) (meminfo_.total - meminfo_.available) / meminfo_.total;
+}
+
+LinuxParser::MemInfo const& System::MemInfo() const {
+    return meminfo_;
+}
+
+LinuxParser::LoadAverage const& System::LoadAverage() const {
+    return loadavg_;
+}
+
+LinuxParser::Pressure const& System::Pressure(int resource) const {
+    return pressure_[resource];
+}
+
+float System::ContextSwitchesPerSecond() const {
+    return context_switches_per_second_;
+}
+
+float System::InterruptsPerSecond() const {
+    return interrupts_per_second_;
 }
 
 std::string System::OperatingSystem() { 
@@ -52,13 +155,34 @@ std::string System::OperatingSystem() {
 }
 
 int System::RunningProcesses() { 
-    return LinuxParser::RunningProcesses();
+    return stat_.procs_running;
 }
 
 int System::TotalProcesses() { 
-    return LinuxParser::TotalProcesses();
+    return stat_.processes;
 }
 
 long int System::UpTime() { 
     return LinuxParser::UpTime();
-}
\ No newline at end of file
+}
+
+bool System::EnableExitAccounting() {
+    return taskstats_.Open();
+}
+
+bool System::ExitAccountingEnabled() const {
+    return taskstats_.IsOpen();
+}
+
+// processes that exited before the last call of Processes()
+vector<ExitedGroup>& System::ExitedProcesses() {
+    return taskstats_.Exited();
+}
+
+float System::ExitedCpuUtilization() const {
+    return taskstats_.TotalCpuLoad();
+}
+
+bool System::ExitedProcessesComplete() const {
+    return taskstats_.Complete();
+}
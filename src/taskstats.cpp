@@ -0,0 +1,291 @@
+#include <linux/genetlink.h>
+#include <linux/netlink.h>
+#include <linux/taskstats.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "taskstats.h"
+
+using std::string;
+using std::vector;
+
+namespace {
+// generic netlink attributes start after the family header
+char const* GenlData(nlmsghdr const* header) {
+  return reinterpret_cast<char const*>(NLMSG_DATA(header)) + GENL_HDRLEN;
+}
+
+std::size_t GenlLength(nlmsghdr const* header) {
+  return header->nlmsg_len - NLMSG_HDRLEN - GENL_HDRLEN;
+}
+}  // namespace
+
+TaskStats::~TaskStats() {
+  if (socket_fd >= 0) {
+    close(socket_fd);
+  }
+}
+
+bool TaskStats::IsOpen() const { return socket_fd >= 0; }
+
+bool TaskStats::Open() {
+  socket_fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_GENERIC);
+  if (socket_fd < 0) {
+    return false;
+  }
+  /* A busy build host can finish thousands of tasks per second, so give the
+     kernel plenty of room to queue records between two refreshes.
+     SO_RCVBUF is capped by net.core.rmem_max, SO_RCVBUFFORCE isn't and only
+     needs the CAP_NET_ADMIN the registration needs anyway. */
+  int receive_buffer = 4 << 20;
+  if (setsockopt(socket_fd, SOL_SOCKET, SO_RCVBUFFORCE, &receive_buffer,
+                 sizeof(receive_buffer)) < 0) {
+    setsockopt(socket_fd, SOL_SOCKET, SO_RCVBUF, &receive_buffer,
+               sizeof(receive_buffer));
+  }
+  sockaddr_nl address{};
+  address.nl_family = AF_NETLINK;
+  buffer.resize(64 * 1024);
+  if (bind(socket_fd, reinterpret_cast<sockaddr*>(&address),
+           sizeof(address)) < 0 ||
+      !ResolveFamilyId()) {
+    close(socket_fd);
+    socket_fd = -1;
+    return false;
+  }
+
+  // listen for exits on every configured CPU, i.e. "0-(n-1)"
+  long cpus = sysconf(_SC_NPROCESSORS_CONF);
+  cpumask = "0-" + std::to_string(cpus > 0 ? cpus - 1 : 0);
+  if (!Send(family_id, TASKSTATS_CMD_GET, TASKSTATS_CMD_ATTR_REGISTER_CPUMASK,
+            cpumask.c_str(), cpumask.size() + 1)) {
+    close(socket_fd);
+    socket_fd = -1;
+    return false;
+  }
+  // the kernel acknowledges a bad request (e.g. missing CAP_NET_ADMIN)
+  // with an error message
+  ssize_t length = recv(socket_fd, buffer.data(), buffer.size(), 0);
+  if (length > 0) {
+    auto header = reinterpret_cast<nlmsghdr const*>(buffer.data());
+    if (header->nlmsg_type == NLMSG_ERROR &&
+        reinterpret_cast<nlmsgerr const*>(NLMSG_DATA(header))->error != 0) {
+      close(socket_fd);
+      socket_fd = -1;
+      return false;
+    }
+    HandleMessages(buffer.data(), length);
+  }
+  last_poll = std::chrono::steady_clock::now();
+  return true;
+}
+
+bool TaskStats::Send(std::uint16_t type, std::uint8_t command,
+                     std::uint16_t attribute, void const* data,
+                     std::size_t length) {
+  struct {
+    nlmsghdr header;
+    genlmsghdr genl;
+    char attributes[256];
+  } message{};
+  if (NLA_HDRLEN + length > sizeof(message.attributes)) {
+    return false;
+  }
+  message.header.nlmsg_type = type;
+  message.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK;
+  message.header.nlmsg_pid = getpid();
+  message.genl.cmd = command;
+  message.genl.version = 1;
+  auto nla = reinterpret_cast<nlattr*>(message.attributes);
+  nla->nla_type = attribute;
+  nla->nla_len = NLA_HDRLEN + length;
+  std::memcpy(message.attributes + NLA_HDRLEN, data, length);
+  message.header.nlmsg_len =
+      NLMSG_LENGTH(GENL_HDRLEN) + NLA_ALIGN(nla->nla_len);
+
+  sockaddr_nl kernel{};
+  kernel.nl_family = AF_NETLINK;
+  return sendto(socket_fd, &message, message.header.nlmsg_len, 0,
+                reinterpret_cast<sockaddr*>(&kernel), sizeof(kernel)) >= 0;
+}
+
+bool TaskStats::ResolveFamilyId() {
+  if (!Send(GENL_ID_CTRL, CTRL_CMD_GETFAMILY, CTRL_ATTR_FAMILY_NAME,
+            TASKSTATS_GENL_NAME, sizeof(TASKSTATS_GENL_NAME))) {
+    return false;
+  }
+  ssize_t length = recv(socket_fd, buffer.data(), buffer.size(), 0);
+  auto header = reinterpret_cast<nlmsghdr const*>(buffer.data());
+  if (length <= 0 || !NLMSG_OK(header, static_cast<std::size_t>(length)) ||
+      header->nlmsg_type == NLMSG_ERROR) {
+    return false;
+  }
+  char const* attributes = GenlData(header);
+  std::size_t remaining = GenlLength(header);
+  while (remaining >= NLA_HDRLEN) {
+    auto nla = reinterpret_cast<nlattr const*>(attributes);
+    if (nla->nla_len < NLA_HDRLEN || nla->nla_len > remaining) {
+      break;
+    }
+    if (nla->nla_type == CTRL_ATTR_FAMILY_ID) {
+      std::memcpy(&family_id, attributes + NLA_HDRLEN, sizeof(family_id));
+    }
+    std::size_t step = std::min<std::size_t>(NLA_ALIGN(nla->nla_len), remaining);
+    attributes += step;
+    remaining -= step;
+  }
+  // drain the ACK that follows the reply
+  recv(socket_fd, buffer.data(), buffer.size(), MSG_DONTWAIT);
+  return family_id != 0;
+}
+
+void TaskStats::HandleMessages(char const* data, std::size_t length) {
+  auto header = reinterpret_cast<nlmsghdr const*>(data);
+  for (; NLMSG_OK(header, length); header = NLMSG_NEXT(header, length)) {
+    if (header->nlmsg_type != family_id) {
+      continue;
+    }
+    char const* attributes = GenlData(header);
+    std::size_t remaining = GenlLength(header);
+    while (remaining >= NLA_HDRLEN) {
+      auto nla = reinterpret_cast<nlattr const*>(attributes);
+      if (nla->nla_len < NLA_HDRLEN || nla->nla_len > remaining) {
+        break;
+      }
+      /* Every exiting thread is reported as AGGR_PID. AGGR_TGID is sent in
+         addition when the last thread of a group exits and would count the
+         same CPU time twice, so it is skipped. */
+      if (nla->nla_type == TASKSTATS_TYPE_AGGR_PID) {
+        HandleStats(attributes + NLA_HDRLEN, nla->nla_len - NLA_HDRLEN);
+      }
+      std::size_t step =
+          std::min<std::size_t>(NLA_ALIGN(nla->nla_len), remaining);
+      attributes += step;
+      remaining -= step;
+    }
+  }
+}
+
+void TaskStats::HandleStats(char const* data, std::size_t length) {
+  while (length >= NLA_HDRLEN) {
+    auto nla = reinterpret_cast<nlattr const*>(data);
+    if (nla->nla_len < NLA_HDRLEN || nla->nla_len > length) {
+      return;
+    }
+    if (nla->nla_type == TASKSTATS_TYPE_STATS) {
+      // older kernels send a shorter struct, newer ones a longer one
+      taskstats stats{};
+      std::size_t const received = nla->nla_len - NLA_HDRLEN;
+      std::memcpy(&stats, data + NLA_HDRLEN,
+                  std::min<std::size_t>(received, sizeof(stats)));
+      string command(stats.ac_comm,
+                     strnlen(stats.ac_comm, sizeof(stats.ac_comm)));
+      /* ac_utime and ac_stime cover the whole life of the task, but only
+         the part the process list has not shown yet belongs to this
+         interval. ac_tgid was added in version 12 of the struct. */
+      std::uint64_t cpu_us = stats.ac_utime + stats.ac_stime;
+      bool const has_tgid =
+          stats.version >= 12 && received >= offsetof(taskstats, ac_tgid) +
+                                                  sizeof(stats.ac_tgid);
+      int const tgid = has_tgid ? stats.ac_tgid : stats.ac_pid;
+      double const sampled =
+          sampled_cpu_ != nullptr ? (*sampled_cpu_)(tgid) : -1;
+      if (sampled < 0 && !has_tgid) {
+        /* Without ac_tgid a thread of a process in the list can't be told
+           from a short-lived process; /proc already counts the former, so
+           leave the record out and report the panel as incomplete. */
+        complete_ = false;
+        return;
+      }
+      if (sampled >= 0) {
+        // the time of the other threads is part of the process's samples
+        if (static_cast<int>(stats.ac_pid) != tgid) {
+          return;
+        }
+        double const sampled_us = sampled * 1e6;
+        cpu_us = cpu_us > sampled_us ? cpu_us - sampled_us : 0;
+      } else if (stats.ac_etime > interval_us) {
+        // never sampled: estimate the share of its run within the interval
+        cpu_us = cpu_us * (interval_us / stats.ac_etime);
+      }
+      /* A process sampled rarely may have run for many intervals since its
+         last sample, but one thread uses at most one CPU per interval. */
+      cpu_us = std::min<std::uint64_t>(cpu_us, interval_us);
+      ExitedGroup& group =
+          groups_[{static_cast<int>(stats.ac_ppid), command}];
+      if (group.count == 0) {
+        group.ppid = stats.ac_ppid;
+        group.command = command;
+      }
+      group.count++;
+      group.cpu_us += cpu_us;
+      group.read_bytes += stats.read_bytes;
+      group.write_bytes += stats.write_bytes;
+    }
+    std::size_t step = std::min<std::size_t>(NLA_ALIGN(nla->nla_len), length);
+    data += step;
+    length -= step;
+  }
+}
+
+/* sampled_cpu returns the CPU time in seconds the process list has already
+   sampled for a process, or a negative value if it never sampled it. It has
+   to be called before dead processes are dropped from the list. */
+void TaskStats::Poll(std::function<double(int)> const& sampled_cpu) {
+  if (!IsOpen()) {
+    return;
+  }
+  auto now = std::chrono::steady_clock::now();
+  interval_us =
+      std::chrono::duration<float, std::micro>(now - last_poll).count();
+  last_poll = now;
+
+  complete_ = true;
+  sampled_cpu_ = &sampled_cpu;
+  for (;;) {
+    ssize_t length =
+        recv(socket_fd, buffer.data(), buffer.size(), MSG_DONTWAIT);
+    if (length > 0) {
+      HandleMessages(buffer.data(), length);
+    } else if (length < 0 && errno == ENOBUFS) {
+      // the queue overflowed and records were dropped, keep draining
+      complete_ = false;
+    } else if (!(length < 0 && errno == EINTR)) {
+      break;
+    }
+  }
+  sampled_cpu_ = nullptr;
+
+  exited_.clear();
+  std::uint64_t total_cpu_us{0};
+  for (auto& entry : groups_) {
+    ExitedGroup& group = entry.second;
+    group.cpu_load = interval_us > 0 ? group.cpu_us / interval_us : 0;
+    total_cpu_us += group.cpu_us;
+    exited_.emplace_back(std::move(group));
+  }
+  groups_.clear();
+  // same order as the process list: biggest CPU consumer first
+  std::sort(exited_.begin(), exited_.end(),
+            [](ExitedGroup const& a, ExitedGroup const& b) {
+              return a.cpu_us > b.cpu_us;
+            });
+
+  // share of the whole machine, comparable to Processor::Utilization()
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  total_cpu_load = interval_us > 0 && cpus > 0
+                       ? total_cpu_us / (interval_us * cpus)
+                       : 0;
+}
+
+vector<ExitedGroup>& TaskStats::Exited() { return exited_; }
+
+float TaskStats::TotalCpuLoad() const { return total_cpu_load; }
+
+bool TaskStats::Complete() const { return complete_; }